@@ -0,0 +1,13 @@
+#pragma once
+
+// By default curlpp is header-only. Building with CURLPP_COMPILED_LIB (set
+// by the curlpp CMake target when CURLPP_COMPILED is ON) keeps the heavier
+// non-template code out of the headers; it is then compiled once into the
+// curlpp library from src/curlpp.cpp.
+#ifdef CURLPP_COMPILED_LIB
+#undef CURLPP_HEADER_ONLY
+#define CURLPP_INLINE
+#else
+#define CURLPP_HEADER_ONLY
+#define CURLPP_INLINE inline
+#endif
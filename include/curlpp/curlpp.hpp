@@ -2,30 +2,23 @@
 
 #include <curl/curl.h>
 
+#include <curlpp/config.hpp>
+#include <curlpp/error.hpp>
 #include <curlpp/info.hpp>
+#include <curlpp/mime.hpp>
 #include <curlpp/opt.hpp>
 #include <curlpp/types.hpp>
+#include <curlpp/url.hpp>
 
 #include <chrono>
+#include <cstdio>
+#include <exception>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 
 namespace curl {
-    struct error : std::runtime_error {
-        error(CURLcode c)   : std::runtime_error(curl_easy_strerror(c))  {}
-        error(CURLMcode c)  : std::runtime_error(curl_multi_strerror(c)) {}
-        error(CURLSHcode c) : std::runtime_error(curl_share_strerror(c)) {}
-    };
-
-    // TODO: Use system_error with curl category
-    CURLcode check(CURLcode c) {
-        if (c != CURLE_OK) {
-            throw error(c);
-        }
-        return c;
-    }
-
-    const char* version() {
+    inline const char* version() {
         return curl_version();
     }
 
@@ -42,6 +35,62 @@ namespace curl {
         private:
             CURL* curl_;
 
+            // Lives on the heap so that WRITEDATA stays valid when the easy
+            // handle is moved.
+            struct write_state {
+                void* sink;
+                void (*feed)(void* sink, const char* data, std::size_t size);
+                // Called after each transfer with whether it succeeded
+                void (*done)(void* sink, bool ok);
+                std::exception_ptr error;
+            };
+            std::unique_ptr<write_state> write_;
+            // Whether a curl::mime is set as MIMEPOST
+            bool mime_ = false;
+
+            template<typename Sink>
+            static void feed_sink(void* sink, const char* data, std::size_t size) {
+                static_cast<Sink*>(sink)->feed(data, size);
+            }
+
+            // finish() and reset() are optional on a sink
+            template<typename Sink>
+            static auto finish_sink(Sink& sink, int) -> decltype(sink.finish(), void()) { sink.finish(); }
+            template<typename Sink>
+            static void finish_sink(Sink&, long) {}
+            template<typename Sink>
+            static auto reset_sink(Sink& sink, int) -> decltype(sink.reset(), void()) { sink.reset(); }
+            template<typename Sink>
+            static void reset_sink(Sink&, long) {}
+
+            template<typename Sink>
+            static void done_sink(void* sink, bool ok) {
+                if (ok)
+                    finish_sink(*static_cast<Sink*>(sink), 0);
+                else
+                    reset_sink(*static_cast<Sink*>(sink), 0);
+            }
+
+            // Exceptions must not unwind through libcurl, so they are stashed
+            // and rethrown from perform(). Returning 0 aborts the transfer.
+            static std::size_t write_callback(char* data, std::size_t size, std::size_t nmemb, void* userdata) {
+                auto* state = static_cast<write_state*>(userdata);
+                try {
+                    state->feed(state->sink, data, size * nmemb);
+                }
+                catch (...) {
+                    state->error = std::current_exception();
+                    return 0;
+                }
+                return size * nmemb;
+            }
+
+            void install_write(std::unique_ptr<write_state> state) {
+                check(curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, &easy::write_callback));
+                check(curl_easy_setopt(curl_, CURLOPT_WRITEDATA, state.get()));
+                write_ = std::move(state);
+            }
+
             template<typename T, typename InfoT>
             T getinfo(InfoT info) {
                 T ret;
@@ -53,18 +102,29 @@ namespace curl {
             easy() : easy(curl_easy_init()) {}
             ~easy() { curl_easy_cleanup(curl_); }
 
-            easy(easy&& o) : curl_(std::exchange(o.curl_, nullptr)) {}
-            easy& operator=(easy&& o) { std::swap(curl_, o.curl_); return *this; }
+            easy(easy&& o) : curl_(std::exchange(o.curl_, nullptr)), write_(std::move(o.write_)), mime_(std::exchange(o.mime_, false)) {}
+            easy& operator=(easy&& o) { std::swap(curl_, o.curl_); std::swap(write_, o.write_); std::swap(mime_, o.mime_); return *this; }
 
             easy(const easy&) = delete;
             easy& operator=(const easy&) = delete;
 
+            CURL* handle() const { return curl_; }
+
             void perform() {
-                check(curl_easy_perform(curl_));
+                CURLcode c = curl_easy_perform(curl_);
+                if (write_) {
+                    bool ok = c == CURLE_OK && !write_->error;
+                    write_->done(write_->sink, ok);
+                    if (write_->error)
+                        std::rethrow_exception(std::exchange(write_->error, nullptr));
+                }
+                check(c);
             }
             
             void reset() {
                 curl_easy_reset(curl_);
+                write_.reset();
+                mime_ = false;
             }
 
             // curl_easy_duphandle
@@ -72,7 +132,31 @@ namespace curl {
                 CURL* new_c = curl_easy_duphandle(curl_);
                 if (!new_c)
                     throw std::runtime_error("curl::easy::duphandle failed");
-                return easy(new_c);
+                easy dup(new_c);
+                // The sink is not shared with the copy; call write_to() on it
+                if (write_) {
+                    check(curl_easy_setopt(new_c, CURLOPT_WRITEFUNCTION, static_cast<curl_write_callback>(nullptr)));
+                    check(curl_easy_setopt(new_c, CURLOPT_WRITEDATA, stdout));
+                }
+                // Neither is the mime: buffer and callback parts keep their read
+                // position in the curl::mime, which two handles cannot share.
+                // The copy is left with an empty MIMEPOST; set one on it.
+                if (mime_)
+                    check(curl_easy_setopt(new_c, CURLOPT_MIMEPOST, static_cast<curl_mime*>(nullptr)));
+                return dup;
+            }
+
+            // Streams the response body into sink.feed(const char*, std::size_t)
+            // chunk by chunk while the transfer runs, e.g. a curl::line_splitter
+            // or curl::ndjson_sink. If the sink has finish() and reset(),
+            // perform() calls finish() after a successful transfer and reset()
+            // after a failed one, so every transfer starts with a clean sink.
+            // The sink must outlive every perform() and must not be shared by
+            // handles that run at the same time; duphandle() does not copy it.
+            template<typename Sink>
+            void write_to(Sink& sink) {
+                reset_sink(sink, 0);
+                install_write(std::unique_ptr<write_state>(new write_state{&sink, &easy::feed_sink<Sink>, &easy::done_sink<Sink>, nullptr}));
             }
 
             // curl_easy_setopt
@@ -82,12 +166,17 @@ namespace curl {
             void setopt(opt::longs opt, long val) {
                 check(curl_easy_setopt(curl_, static_cast<CURLoption>(opt), val));
             }
-            void setopt(opt::bools opt, boolean val) {
+            void setopt(opt::bools opt, bool val) {
                 check(curl_easy_setopt(curl_, static_cast<CURLoption>(opt), static_cast<long>(val)));
             }
             void setopt(opt::off_ts opt, curl_off_t val) {
                 check(curl_easy_setopt(curl_, static_cast<CURLoption>(opt), val));
             }
+            // The mime structure is not copied and must outlive every perform()
+            void setopt(opt::mimes opt, const mime& val) {
+                check(curl_easy_setopt(curl_, static_cast<CURLoption>(opt), val.get()));
+                mime_ = true;
+            }
 
             // curl_easy_getinfo
             long getinfo(info::longs info) {
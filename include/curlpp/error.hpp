@@ -0,0 +1,21 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <stdexcept>
+
+namespace curl {
+    struct error : std::runtime_error {
+        error(CURLcode c)   : std::runtime_error(curl_easy_strerror(c))  {}
+        error(CURLMcode c)  : std::runtime_error(curl_multi_strerror(c)) {}
+        error(CURLSHcode c) : std::runtime_error(curl_share_strerror(c)) {}
+    };
+
+    // TODO: Use system_error with curl category
+    inline CURLcode check(CURLcode c) {
+        if (c != CURLE_OK) {
+            throw error(c);
+        }
+        return c;
+    }
+}
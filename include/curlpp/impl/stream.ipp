@@ -0,0 +1,243 @@
+#pragma once
+
+#include <curlpp/stream.hpp>
+
+#include <cctype>
+
+namespace curl {
+    CURLPP_INLINE bool json_tokenizer::string(json_token& tok, json_token_type type) {
+        const char* start = ++pos_;
+        bool escaped = false;
+        while (pos_ != end_) {
+            unsigned char c = *pos_;
+            if (c == '"') {
+                emit(tok, type, start, pos_ - start);
+                tok.escaped = escaped;
+                ++pos_;
+                return true;
+            }
+            if (c < 0x20)
+                fail("control character in string");
+            if (c == '\\') {
+                escaped = true;
+                if (++pos_ == end_)
+                    break;
+                switch (*pos_) {
+                    case '"': case '\\': case '/':
+                    case 'b': case 'f': case 'n': case 'r': case 't':
+                        break;
+                    case 'u':
+                        for (int i = 0; i < 4; ++i) {
+                            if (++pos_ == end_)
+                                fail("unterminated string");
+                            if (!std::isxdigit(static_cast<unsigned char>(*pos_)))
+                                fail("invalid \\u escape");
+                        }
+                        break;
+                    default:
+                        fail("invalid escape");
+                }
+            }
+            ++pos_;
+        }
+        fail("unterminated string");
+    }
+
+    CURLPP_INLINE bool json_tokenizer::number(json_token& tok) {
+        auto digits = [this] {
+            const char* start = pos_;
+            while (pos_ != end_ && *pos_ >= '0' && *pos_ <= '9')
+                ++pos_;
+            return pos_ != start;
+        };
+        const char* start = pos_;
+        if (*pos_ == '-')
+            ++pos_;
+        if (pos_ != end_ && *pos_ == '0')
+            ++pos_;
+        else if (!digits())
+            fail("invalid number");
+        if (pos_ != end_ && *pos_ == '.') {
+            ++pos_;
+            if (!digits())
+                fail("invalid number");
+        }
+        if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+            ++pos_;
+            if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-'))
+                ++pos_;
+            if (!digits())
+                fail("invalid number");
+        }
+        return emit(tok, json_token_type::NUMBER, start, pos_ - start);
+    }
+
+    CURLPP_INLINE bool json_tokenizer::literal(json_token& tok, const char* word, std::size_t size, json_token_type type) {
+        if (static_cast<std::size_t>(end_ - pos_) < size || std::memcmp(pos_, word, size) != 0)
+            fail("invalid literal");
+        emit(tok, type, pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    CURLPP_INLINE bool json_tokenizer::value(json_token& tok) {
+        switch (*pos_) {
+            case '{':
+                stack_.push_back('{');
+                state_ = state::FIRST_KEY;
+                emit(tok, json_token_type::BEGIN_OBJECT, pos_++, 1);
+                return true;
+            case '[':
+                stack_.push_back('[');
+                state_ = state::FIRST_VALUE;
+                emit(tok, json_token_type::BEGIN_ARRAY, pos_++, 1);
+                return true;
+            case '"':
+                string(tok, json_token_type::STRING);
+                break;
+            case 't':
+                literal(tok, "true", 4, json_token_type::BOOLEAN);
+                break;
+            case 'f':
+                literal(tok, "false", 5, json_token_type::BOOLEAN);
+                break;
+            case 'n':
+                literal(tok, "null", 4, json_token_type::NULL_VALUE);
+                break;
+            default:
+                if (*pos_ != '-' && (*pos_ < '0' || *pos_ > '9'))
+                    fail("unexpected character");
+                number(tok);
+                break;
+        }
+        after_value();
+        return true;
+    }
+
+    CURLPP_INLINE bool json_tokenizer::next(json_token& tok) {
+        for (;;) {
+            skip_ws();
+            if (state_ == state::DONE) {
+                if (pos_ != end_)
+                    fail("trailing characters");
+                return false;
+            }
+            if (pos_ == end_)
+                fail("unexpected end of input");
+
+            switch (state_) {
+                case state::COLON:
+                    if (*pos_ != ':')
+                        fail("expected ':'");
+                    ++pos_;
+                    state_ = state::VALUE;
+                    continue;
+                case state::NEXT:
+                    if (*pos_ == ',') {
+                        ++pos_;
+                        state_ = stack_.back() == '{' ? state::KEY : state::VALUE;
+                        continue;
+                    }
+                    if (*pos_ == '}' && stack_.back() == '{')
+                        return close(tok, json_token_type::END_OBJECT);
+                    if (*pos_ == ']' && stack_.back() == '[')
+                        return close(tok, json_token_type::END_ARRAY);
+                    fail("expected ',' or closing bracket");
+                case state::FIRST_KEY:
+                    if (*pos_ == '}')
+                        return close(tok, json_token_type::END_OBJECT);
+                    // fallthrough
+                case state::KEY:
+                    if (*pos_ != '"')
+                        fail("expected object key");
+                    string(tok, json_token_type::KEY);
+                    state_ = state::COLON;
+                    return true;
+                case state::FIRST_VALUE:
+                    if (*pos_ == ']')
+                        return close(tok, json_token_type::END_ARRAY);
+                    // fallthrough
+                case state::VALUE:
+                    return value(tok);
+                case state::DONE:
+                    break;
+            }
+        }
+    }
+
+    CURLPP_INLINE std::string json_token::str() const {
+        if (!escaped)
+            return raw();
+
+        auto hex4 = [](const char* p) {
+            unsigned v = 0;
+            for (int i = 0; i < 4; ++i) {
+                char c = p[i];
+                v <<= 4;
+                if (c >= '0' && c <= '9')      v |= c - '0';
+                else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+                else throw json_error("curl::json_token: invalid \\u escape");
+            }
+            return v;
+        };
+
+        std::string out;
+        out.reserve(size);
+        const char* p = data;
+        const char* end = data + size;
+        while (p != end) {
+            if (*p != '\\') {
+                out += *p++;
+                continue;
+            }
+            ++p;
+            switch (*p++) {
+                case '"':  out += '"';  break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/';  break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    if (end - p < 4)
+                        throw json_error("curl::json_token: invalid \\u escape");
+                    unsigned cp = hex4(p);
+                    p += 4;
+                    if (cp >= 0xD800 && cp < 0xDC00) {
+                        if (end - p < 6 || p[0] != '\\' || p[1] != 'u')
+                            throw json_error("curl::json_token: unpaired surrogate");
+                        unsigned lo = hex4(p + 2);
+                        if (lo < 0xDC00 || lo >= 0xE000)
+                            throw json_error("curl::json_token: unpaired surrogate");
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        p += 6;
+                    } else if (cp >= 0xDC00 && cp < 0xE000) {
+                        throw json_error("curl::json_token: unpaired surrogate");
+                    }
+                    if (cp < 0x80) {
+                        out += static_cast<char>(cp);
+                    } else if (cp < 0x800) {
+                        out += static_cast<char>(0xC0 | (cp >> 6));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    } else if (cp < 0x10000) {
+                        out += static_cast<char>(0xE0 | (cp >> 12));
+                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xF0 | (cp >> 18));
+                        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    throw json_error("curl::json_token: invalid escape");
+            }
+        }
+        return out;
+    }
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <curl/curl.h>
+
+#include <curlpp/error.hpp>
+#include <curlpp/types.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace curl {
+    class mime;
+
+    // Read state of buffer and callback parts, owned by the curl::mime and
+    // not by libcurl: curl_easy_duphandle() copies MIMEPOST parts together
+    // with their callback argument, so a libcurl free callback would run
+    // once per copy.
+    using mime_sources = std::vector<std::unique_ptr<void, void (*)(void*)>>;
+
+    // Non-owning handle to a part of a curl::mime; valid as long as the
+    // mime it was added to.
+    class mime_part {
+        private:
+            curl_mimepart* part_;
+            mime_sources* sources_;
+
+            // Caller-owned memory, read in place by libcurl
+            struct buffer_source {
+                const char* data;
+                std::size_t size;
+                std::size_t pos;
+
+                static std::size_t read(char* buf, std::size_t size, std::size_t nitems, void* arg) {
+                    auto* src = static_cast<buffer_source*>(arg);
+                    std::size_t n = std::min(size * nitems, src->size - src->pos);
+                    std::memcpy(buf, src->data + src->pos, n);
+                    src->pos += n;
+                    return n;
+                }
+                static int seek(void* arg, curl_off_t offset, int origin) {
+                    auto* src = static_cast<buffer_source*>(arg);
+                    if (origin != SEEK_SET)
+                        return CURL_SEEKFUNC_CANTSEEK;
+                    if (offset < 0 || static_cast<curl_off_t>(src->size) < offset)
+                        return CURL_SEEKFUNC_FAIL;
+                    src->pos = static_cast<std::size_t>(offset);
+                    return CURL_SEEKFUNC_OK;
+                }
+                static void free(void* arg) {
+                    delete static_cast<buffer_source*>(arg);
+                }
+            };
+
+            template<typename Read, typename Rewind>
+            struct callback_source {
+                Read read_fn;
+                Rewind rewind_fn;
+
+                // Exceptions must not unwind through libcurl, they abort the transfer
+                static std::size_t read(char* buf, std::size_t size, std::size_t nitems, void* arg) {
+                    try {
+                        return static_cast<callback_source*>(arg)->read_fn(buf, size * nitems);
+                    }
+                    catch (...) {
+                        return CURL_READFUNC_ABORT;
+                    }
+                }
+                static int seek(void* arg, curl_off_t offset, int origin) {
+                    if (offset != 0 || origin != SEEK_SET)
+                        return CURL_SEEKFUNC_CANTSEEK;
+                    try {
+                        return static_cast<callback_source*>(arg)->rewind_fn() ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_CANTSEEK;
+                    }
+                    catch (...) {
+                        return CURL_SEEKFUNC_FAIL;
+                    }
+                }
+                static void free(void* arg) {
+                    delete static_cast<callback_source*>(arg);
+                }
+            };
+
+            struct no_rewind {
+                bool operator()() const { return false; }
+            };
+
+            template<typename Source>
+            mime_part& data_cb(curl_off_t size, std::unique_ptr<Source> src) {
+                Source* arg = src.get();
+                sources_->emplace_back(src.release(), &Source::free);
+                CURLcode c = curl_mime_data_cb(part_, size, &Source::read, &Source::seek, nullptr, arg);
+                if (c != CURLE_OK) {
+                    sources_->pop_back();
+                    throw error(c);
+                }
+                return *this;
+            }
+        public:
+            mime_part(curl_mimepart* part, mime_sources* sources) : part_(part), sources_(sources) {}
+
+            curl_mimepart* get() const { return part_; }
+
+            mime_part& name(const char* val) {
+                check(curl_mime_name(part_, val));
+                return *this;
+            }
+            mime_part& filename(const char* val) {
+                check(curl_mime_filename(part_, val));
+                return *this;
+            }
+            mime_part& type(const char* val) {
+                check(curl_mime_type(part_, val));
+                return *this;
+            }
+            mime_part& encoder(const char* val) {
+                check(curl_mime_encoder(part_, val));
+                return *this;
+            }
+            mime_part& headers(slist&& val) {
+                check(curl_mime_headers(part_, val.get(), 1));
+                val.release();
+                return *this;
+            }
+
+            // Copies the data into the part
+            mime_part& data(const char* val, std::size_t size) {
+                check(curl_mime_data(part_, val, size));
+                return *this;
+            }
+            mime_part& data(const std::string& val) {
+                return data(val.data(), val.size());
+            }
+
+            // Sends caller-owned memory without copying it into the part.
+            // The buffer must stay valid and unchanged for every transfer
+            // that uses this part.
+            mime_part& buffer(const void* val, std::size_t size) {
+                std::unique_ptr<buffer_source> src(new buffer_source{static_cast<const char*>(val), size, 0});
+                return data_cb(static_cast<curl_off_t>(size), std::move(src));
+            }
+
+            // Streams the file contents during the transfer, nothing is read
+            // up front. Also sets the part's filename to the basename.
+            mime_part& file(const char* path) {
+                check(curl_mime_filedata(part_, path));
+                return *this;
+            }
+
+            // read(char* buf, std::size_t max) fills buf and returns the number
+            // of bytes written, 0 at the end of data. size is the total part
+            // size, or -1 if unknown (forces chunked encoding). Without a
+            // rewind callback the part can only be sent once.
+            template<typename Read>
+            mime_part& callback(curl_off_t size, Read read) {
+                return callback(size, std::move(read), no_rewind());
+            }
+            // rewind() restarts the data from the beginning and returns
+            // whether it succeeded, this allows resending the part.
+            template<typename Read, typename Rewind>
+            mime_part& callback(curl_off_t size, Read read, Rewind rewind) {
+                using source = callback_source<Read, Rewind>;
+                std::unique_ptr<source> src(new source{std::move(read), std::move(rewind)});
+                return data_cb(size, std::move(src));
+            }
+
+            // Nests a multipart structure; the part takes ownership of it
+            mime_part& subparts(mime&& val);
+    };
+
+    // Multipart/MIME structure for opt::MIMEPOST. It is not tied to a single
+    // request: as long as every part can be rewound (data, buffer, file, or
+    // callback with rewind) the same mime can be posted again, but only by
+    // one handle; easy::duphandle() does not carry it over to the copy.
+    class mime {
+        private:
+            friend class mime_part;
+
+            curl_mime* mime_;
+            // On the heap so that mime_part handles survive moving the mime
+            std::unique_ptr<mime_sources> sources_;
+        public:
+            explicit mime(CURL* handle) : mime_(curl_mime_init(handle)), sources_(new mime_sources) {
+                if (!mime_)
+                    throw std::runtime_error("curl::mime::mime failed");
+            }
+            ~mime() { curl_mime_free(mime_); }
+
+            mime(mime&& o) : mime_(std::exchange(o.mime_, nullptr)), sources_(std::move(o.sources_)) {}
+            mime& operator=(mime&& o) { std::swap(mime_, o.mime_); std::swap(sources_, o.sources_); return *this; }
+
+            mime(const mime&) = delete;
+            mime& operator=(const mime&) = delete;
+
+            curl_mime* get() const { return mime_; }
+
+            mime_part add_part() {
+                curl_mimepart* part = curl_mime_addpart(mime_);
+                if (!part)
+                    throw std::runtime_error("curl::mime::add_part failed");
+                return mime_part(part, sources_.get());
+            }
+    };
+
+    // The parent mime adopts the sources of the nested one, which libcurl
+    // frees together with the parent.
+    inline mime_part& mime_part::subparts(mime&& val) {
+        sources_->reserve(sources_->size() + val.sources_->size());
+        check(curl_mime_subparts(part_, val.mime_));
+        val.mime_ = nullptr;
+        for (auto& src : *val.sources_)
+            sources_->push_back(std::move(src));
+        val.sources_->clear();
+        return *this;
+    }
+}
@@ -216,6 +216,9 @@ namespace curl {
             MAX_RECV_SPEED_LARGE        = CURLOPT_MAX_RECV_SPEED_LARGE,
             TIMEVALUE_LARGE             = CURLOPT_TIMEVALUE_LARGE,
         };
+        enum mimes {
+            MIMEPOST                    = CURLOPT_MIMEPOST,
+        };
 
         enum functions {
             WRITEFUNCTION               = CURLOPT_WRITEFUNCTION,
@@ -281,7 +284,6 @@ namespace curl {
   CINIT(STREAM_DEPENDS, OBJECTPOINT, 240),
   CINIT(STREAM_DEPENDS_E, OBJECTPOINT, 241),
   CINIT(CONNECT_TO, OBJECTPOINT, 243),
-  CINIT(MIMEPOST, OBJECTPOINT, 269),
   CINIT(CURLU, OBJECTPOINT, 282),
 #endif
 }
\ No newline at end of file
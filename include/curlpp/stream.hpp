@@ -0,0 +1,224 @@
+#pragma once
+
+#include <curlpp/config.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace curl {
+    struct json_error : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    // Splits a byte stream into lines as chunks arrive and calls
+    // f(const char* data, std::size_t size) once per line, without the
+    // trailing "\n" or "\r\n". Lines that lie completely inside a chunk are
+    // passed straight out of it; only a line that straddles two chunks is
+    // copied into the carry buffer. finish() flushes a last line that is not
+    // newline-terminated, reset() drops it; curl::easy::perform() calls them
+    // for sinks attached with write_to().
+    template<typename F>
+    class line_splitter {
+        private:
+            F on_line_;
+            std::string carry_;
+            std::size_t max_line_;
+
+            void emit(const char* data, std::size_t size) {
+                if (size > 0 && data[size - 1] == '\r')
+                    --size;
+                on_line_(data, size);
+            }
+            void check_length(std::size_t size) const {
+                if (max_line_ && size > max_line_)
+                    throw std::length_error("curl::line_splitter: line too long");
+            }
+        public:
+            // max_line == 0 means no limit on the length of a single line
+            explicit line_splitter(F f, std::size_t max_line = 0)
+                : on_line_(std::move(f)), max_line_(max_line) {}
+
+            void feed(const char* data, std::size_t size) {
+                const char* end = data + size;
+                // memchr is the vectorized newline scan on every libc we target
+                const char* nl = static_cast<const char*>(std::memchr(data, '\n', size));
+
+                if (!carry_.empty()) {
+                    if (!nl) {
+                        check_length(carry_.size() + size);
+                        carry_.append(data, size);
+                        return;
+                    }
+                    check_length(carry_.size() + (nl - data));
+                    carry_.append(data, nl);
+                    emit(carry_.data(), carry_.size());
+                    carry_.clear();
+                    data = nl + 1;
+                    nl = static_cast<const char*>(std::memchr(data, '\n', end - data));
+                }
+                while (nl) {
+                    check_length(nl - data);
+                    emit(data, nl - data);
+                    data = nl + 1;
+                    nl = static_cast<const char*>(std::memchr(data, '\n', end - data));
+                }
+                if (data != end) {
+                    check_length(end - data);
+                    carry_.assign(data, end);
+                }
+            }
+
+            void finish() {
+                if (!carry_.empty()) {
+                    std::string last;
+                    std::swap(last, carry_);
+                    emit(last.data(), last.size());
+                }
+            }
+
+            void reset() {
+                carry_.clear();
+            }
+    };
+
+    template<typename F>
+    line_splitter<F> make_line_splitter(F f, std::size_t max_line = 0) {
+        return line_splitter<F>(std::move(f), max_line);
+    }
+
+    enum class json_token_type {
+        BEGIN_OBJECT,
+        END_OBJECT,
+        BEGIN_ARRAY,
+        END_ARRAY,
+        KEY,
+        STRING,
+        NUMBER,
+        BOOLEAN,
+        NULL_VALUE,
+    };
+
+    // A token points into the tokenizer input and is only valid as long as
+    // that input is. For KEY and STRING, data/size cover the raw contents
+    // between the quotes; escaped is set if they contain backslash escapes
+    // and str() has to decode them. Escapes are validated by the tokenizer,
+    // unpaired UTF-16 surrogates only by str().
+    struct json_token {
+        json_token_type type = json_token_type::NULL_VALUE;
+        const char* data = nullptr;
+        std::size_t size = 0;
+        bool escaped = false;
+
+        bool boolean() const {
+            return type == json_token_type::BOOLEAN && data[0] == 't';
+        }
+        std::string raw() const {
+            return std::string(data, size);
+        }
+        std::string str() const;
+    };
+
+    // Pull-based tokenizer for a single JSON document. Every call to next()
+    // validates and returns one token; it returns false once the document
+    // is complete. Nothing is allocated except the container nesting stack.
+    class json_tokenizer {
+        private:
+            enum class state { VALUE, FIRST_VALUE, KEY, FIRST_KEY, COLON, NEXT, DONE };
+
+            const char* begin_;
+            const char* pos_;
+            const char* end_;
+            std::vector<char> stack_;
+            state state_ = state::VALUE;
+
+            [[noreturn]] void fail(const char* what) const {
+                throw json_error(std::string("curl::json_tokenizer: ") + what
+                    + " at offset " + std::to_string(pos_ - begin_));
+            }
+            void skip_ws() {
+                while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r'))
+                    ++pos_;
+            }
+            void after_value() {
+                state_ = stack_.empty() ? state::DONE : state::NEXT;
+            }
+            bool emit(json_token& tok, json_token_type type, const char* data, std::size_t size) {
+                tok.type = type;
+                tok.data = data;
+                tok.size = size;
+                tok.escaped = false;
+                return true;
+            }
+            bool close(json_token& tok, json_token_type type) {
+                stack_.pop_back();
+                emit(tok, type, pos_, 1);
+                ++pos_;
+                after_value();
+                return true;
+            }
+            bool string(json_token& tok, json_token_type type);
+            bool number(json_token& tok);
+            bool literal(json_token& tok, const char* word, std::size_t size, json_token_type type);
+            bool value(json_token& tok);
+        public:
+            json_tokenizer(const char* data, std::size_t size)
+                : begin_(data), pos_(data), end_(data + size) {}
+            explicit json_tokenizer(const std::string& s)
+                : json_tokenizer(s.data(), s.size()) {}
+            // Tokens point into the input, which must outlive the tokenizer
+            explicit json_tokenizer(std::string&&) = delete;
+
+            // Starts over on a new document, keeping the stack's capacity
+            void reset(const char* data, std::size_t size) {
+                begin_ = pos_ = data;
+                end_ = data + size;
+                stack_.clear();
+                state_ = state::VALUE;
+            }
+
+            const char* data() const { return begin_; }
+            std::size_t size() const { return end_ - begin_; }
+            std::size_t depth() const { return stack_.size(); }
+
+            bool next(json_token& tok);
+    };
+
+    // Line handler for NDJSON: skips blank lines and calls
+    // f(json_tokenizer&) once per record. One tokenizer is reused for all
+    // records so that its nesting stack is not reallocated per line.
+    template<typename F>
+    struct ndjson_records {
+        F on_record;
+        json_tokenizer tok{nullptr, 0};
+
+        void operator()(const char* data, std::size_t size) {
+            std::size_t i = 0;
+            while (i != size && (data[i] == ' ' || data[i] == '\t'))
+                ++i;
+            if (i == size)
+                return;
+            tok.reset(data, size);
+            on_record(tok);
+        }
+    };
+
+    template<typename F>
+    using ndjson_sink = line_splitter<ndjson_records<F>>;
+
+    // Usage:
+    //   auto sink = curl::make_ndjson_sink([](curl::json_tokenizer& rec) { ... });
+    //   conn.write_to(sink);
+    //   conn.perform();
+    template<typename F>
+    ndjson_sink<F> make_ndjson_sink(F f, std::size_t max_line = 0) {
+        return ndjson_sink<F>(ndjson_records<F>{std::move(f)}, max_line);
+    }
+}
+
+#ifdef CURLPP_HEADER_ONLY
+#include <curlpp/impl/stream.ipp>
+#endif
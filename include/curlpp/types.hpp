@@ -1,8 +1,12 @@
 #pragma once
 
 #include <curl/curl.h>
-#include <iterator>
 #include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace curl {
     enum class protocol {
@@ -62,7 +66,7 @@ namespace curl {
                 node = node->next;
                 return *this;
             }
-            slist_iterator& operator++(int) {
+            slist_iterator operator++(int) {
                 slist_iterator copy(*this);
                 node = node->next;
                 return copy; 
@@ -112,6 +116,15 @@ namespace curl {
             void append(const std::string& s) {
                 append(s.c_str());
             }
+
+            curl_slist* get() const {
+                return list_;
+            }
+
+            // Gives up ownership of the list, e.g. to hand it to libcurl
+            curl_slist* release() {
+                return std::exchange(list_, nullptr);
+            }
     };
 
     struct curl_string_deleter {
@@ -2,8 +2,14 @@
 
 #include <curl/curl.h>
 
+#include <curlpp/types.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 namespace curl {
-    const char* curl_url_strerror(CURLUcode code) {
+    inline const char* curl_url_strerror(CURLUcode code) {
         switch (code) {
             case CURLUE_OK:                  return "OK";
             case CURLUE_BAD_HANDLE:          return "bad handle";
@@ -24,65 +30,66 @@ namespace curl {
             case CURLUE_NO_QUERY:            return "no query";
             case CURLUE_NO_FRAGMENT:         return "no fragment";
         }
+        return "unknown error";
+    }
+
+    struct url_error : std::runtime_error {
+        url_error(CURLUcode c) : std::runtime_error(curl::curl_url_strerror(c)) {}
     };
 
+    inline CURLUcode check(CURLUcode c) {
+        if (c != CURLUE_OK) {
+            throw url_error(c);
+        }
+        return c;
+    }
+
     enum class url_part {
-        URL,
-        SCHEME,
-        USER,
-        PASSWORD,
-        OPTIONS,
-        HOST,
-        PORT,
-        PATH,
-        QUERY,
-        FRAGMENT,
+        URL         = CURLUPART_URL,
+        SCHEME      = CURLUPART_SCHEME,
+        USER        = CURLUPART_USER,
+        PASSWORD    = CURLUPART_PASSWORD,
+        OPTIONS     = CURLUPART_OPTIONS,
+        HOST        = CURLUPART_HOST,
+        PORT        = CURLUPART_PORT,
+        PATH        = CURLUPART_PATH,
+        QUERY       = CURLUPART_QUERY,
+        FRAGMENT    = CURLUPART_FRAGMENT,
     };
 
+    // flags are the CURLU_* bits from curl/urlapi.h
     class URL {
         private:
             CURLU* url_;
         public:
-            URL(CURLU* u) : url_(u) {}
+            URL(CURLU* u) : url_(u) {
+                if (!url_)
+                    throw std::runtime_error("curl::URL::URL failed");
+            }
             URL() : URL(curl_url()) {}
-            ~URL() { curl_urL_cleanup(url_); }
-            
-            URL(const URL& o) : url_(curl_url_dup(o.url_)) {}
-            URL(URL&& o) : url_(std::exchange(o.url_, nullptr)) {}
-
-            URL& operator=(const URL& o) {}
+            ~URL() { curl_url_cleanup(url_); }
 
+            URL(const URL& o) : URL(curl_url_dup(o.url_)) {}
+            URL(URL&& o) : url_(std::exchange(o.url_, nullptr)) {}
 
+            URL& operator=(const URL& o) { URL copy(o); std::swap(url_, copy.url_); return *this; }
+            URL& operator=(URL&& o) { std::swap(url_, o.url_); return *this; }
 
-/*
- * curl_url_get() extracts a specific part of the URL from a CURLU
- * handle. Returns error code. The returned pointer MUST be freed with
- * curl_free() afterwards.
- */
-CURL_EXTERN CURLUcode curl_url_get(CURLU *handle, CURLUPart what,
-                                   char **part, unsigned int flags);
+            CURLU* handle() const { return url_; }
 
+            // curl_url_get
+            curl_string get(url_part part, unsigned int flags = 0) const {
+                char* val = nullptr;
+                check(curl_url_get(url_, static_cast<CURLUPart>(part), &val, flags));
+                return curl_string(val);
+            }
 
-/*
- * curl_url_set() sets a specific part of the URL in a CURLU handle. Returns
- * error code. The passed in string will be copied. Passing a NULL instead of
- * a part string, clears that part.
- */
-CURL_EXTERN CURLUcode curl_url_set(CURLU *handle, CURLUPart what,
-                                   const char *part, unsigned int flags);
+            // curl_url_set; the value is copied, nullptr clears the part
+            void set(url_part part, const char* val, unsigned int flags = 0) {
+                check(curl_url_set(url_, static_cast<CURLUPart>(part), val, flags));
+            }
+            void set(url_part part, const std::string& val, unsigned int flags = 0) {
+                set(part, val.c_str(), flags);
+            }
     };
-
-#define CURLU_DEFAULT_PORT (1<<0)       /* return default port number */
-#define CURLU_NO_DEFAULT_PORT (1<<1)    /* act as if no port number was set,
-                                           if the port number matches the
-                                           default for the scheme */
-#define CURLU_DEFAULT_SCHEME (1<<2)     /* return default scheme if
-                                           missing */
-#define CURLU_NON_SUPPORT_SCHEME (1<<3) /* allow non-supported scheme */
-#define CURLU_PATH_AS_IS (1<<4)         /* leave dot sequences */
-#define CURLU_DISALLOW_USER (1<<5)      /* no user+password allowed */
-#define CURLU_URLDECODE (1<<6)          /* URL decode on get */
-#define CURLU_URLENCODE (1<<7)          /* URL encode on set */
-#define CURLU_APPENDQUERY (1<<8)        /* append a form style part */
-#define CURLU_GUESS_SCHEME (1<<9)       /* legacy curl-style guessing */
-
+}
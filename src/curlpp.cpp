@@ -0,0 +1,5 @@
+#ifndef CURLPP_COMPILED_LIB
+#error "src/curlpp.cpp is only built for the compiled curlpp library (CURLPP_COMPILED=ON)"
+#endif
+
+#include <curlpp/impl/stream.ipp>
@@ -0,0 +1,65 @@
+#include <curlpp/curlpp.hpp>
+#include <curlpp/stream.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    std::string file_url(const std::string& name, const std::string& contents) {
+        std::string path = std::string(CURLPP_TEST_DIR) + "/" + name;
+        std::ofstream(path, std::ios::binary) << contents;
+        return "file://" + path;
+    }
+}
+
+TEST_CASE("write_to streams records from a transfer") {
+    curl::global_init init;
+    curl::easy conn;
+    int records = 0;
+    auto sink = curl::make_ndjson_sink([&](curl::json_tokenizer&) { ++records; });
+    conn.write_to(sink);
+    conn.setopt(curl::opt::URL, file_url("records.ndjson", "{\"a\":1}\n{\"b\":2}\n{\"c\":3}").c_str());
+    conn.perform();
+    CHECK(records == 3);
+}
+
+TEST_CASE("write_to exceptions propagate out of perform") {
+    curl::global_init init;
+    curl::easy conn;
+    auto sink = curl::make_line_splitter([](const char*, std::size_t) {
+        throw std::logic_error("boom");
+    });
+    conn.write_to(sink);
+    conn.setopt(curl::opt::URL, file_url("boom.txt", "line\n").c_str());
+    CHECK_THROWS_WITH(conn.perform(), "boom");
+}
+
+TEST_CASE("write_to sink starts clean on every transfer") {
+    curl::global_init init;
+    curl::easy conn;
+    int records = 0;
+    auto sink = curl::make_ndjson_sink([&](curl::json_tokenizer& rec) {
+        curl::json_token t;
+        while (rec.next(t)) {}
+        ++records;
+    });
+    conn.write_to(sink);
+
+    SECTION("after a transfer ending in a partial record") {
+        conn.setopt(curl::opt::URL, file_url("partial.ndjson", "{\"a\":1}\n{\"b\":").c_str());
+        CHECK_THROWS_AS(conn.perform(), curl::json_error);
+    }
+    SECTION("after a failed transfer") {
+        sink.feed("{\"b\":", 5);
+        conn.setopt(curl::opt::URL, "file:///nonexistent/curlpp");
+        CHECK_THROWS_AS(conn.perform(), curl::error);
+    }
+
+    records = 0;
+    conn.setopt(curl::opt::URL, file_url("complete.ndjson", "{\"c\":3}\n").c_str());
+    conn.perform();
+    CHECK(records == 1);
+}
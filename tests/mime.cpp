@@ -0,0 +1,226 @@
+#include <curlpp/curlpp.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace {
+    // Minimal HTTP/1.1 server on 127.0.0.1 that echoes each request body
+    // back as the response body, one request per connection.
+    class echo_server {
+        private:
+            int fd_ = -1;
+            int port_ = 0;
+            std::atomic<bool> stop_{false};
+            std::thread thread_;
+
+            static std::string lower(std::string s) {
+                std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+                return s;
+            }
+            static bool send_all(int fd, const std::string& s) {
+                for (std::size_t sent = 0; sent < s.size();) {
+                    ssize_t n = ::send(fd, s.data() + sent, s.size() - sent, MSG_NOSIGNAL);
+                    if (n <= 0)
+                        return false;
+                    sent += n;
+                }
+                return true;
+            }
+            static void serve(int fd) {
+                std::string in;
+                char buf[4096];
+                std::size_t header_end;
+                while ((header_end = in.find("\r\n\r\n")) == std::string::npos) {
+                    ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+                    if (n <= 0)
+                        return;
+                    in.append(buf, n);
+                }
+                std::string headers = lower(in.substr(0, header_end));
+                std::size_t length = 0;
+                std::size_t cl = headers.find("\r\ncontent-length:");
+                if (cl != std::string::npos)
+                    length = std::stoul(headers.substr(cl + 17));
+                if (headers.find("100-continue") != std::string::npos && !send_all(fd, "HTTP/1.1 100 Continue\r\n\r\n"))
+                    return;
+                std::string body = in.substr(header_end + 4);
+                while (body.size() < length) {
+                    ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+                    if (n <= 0)
+                        return;
+                    body.append(buf, n);
+                }
+                send_all(fd, "HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: "
+                    + std::to_string(body.size()) + "\r\n\r\n" + body);
+            }
+            void run() {
+                while (!stop_) {
+                    pollfd p{fd_, POLLIN, 0};
+                    if (::poll(&p, 1, 50) <= 0)
+                        continue;
+                    int client = ::accept(fd_, nullptr, nullptr);
+                    if (client < 0)
+                        continue;
+                    serve(client);
+                    ::close(client);
+                }
+            }
+        public:
+            echo_server() {
+                fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+                REQUIRE(fd_ >= 0);
+                sockaddr_in addr{};
+                addr.sin_family = AF_INET;
+                addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                REQUIRE(::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+                REQUIRE(::listen(fd_, 8) == 0);
+                socklen_t len = sizeof(addr);
+                REQUIRE(::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+                port_ = ntohs(addr.sin_port);
+                thread_ = std::thread([this] { run(); });
+            }
+            ~echo_server() {
+                stop_ = true;
+                thread_.join();
+                ::close(fd_);
+            }
+
+            std::string url() const {
+                return "http://127.0.0.1:" + std::to_string(port_) + "/";
+            }
+    };
+
+    struct string_sink {
+        std::string body;
+        void feed(const char* data, std::size_t size) { body.append(data, size); }
+        void reset() { body.clear(); }
+    };
+
+    std::size_t count(const std::string& haystack, const std::string& needle) {
+        std::size_t n = 0;
+        for (std::size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1))
+            ++n;
+        return n;
+    }
+}
+
+TEST_CASE("mime posts reusable parts on repeated requests") {
+    curl::global_init init;
+    echo_server server;
+    curl::easy conn;
+    conn.setopt(curl::opt::URL, server.url().c_str());
+
+    static const char payload[] = "zero-copy buffer payload";
+    const std::string generated = "generated by callback";
+    std::size_t pos = 0;
+
+    curl::mime form(conn.handle());
+    form.add_part().name("buffer").buffer(payload, sizeof(payload) - 1);
+    form.add_part().name("callback").callback(static_cast<curl_off_t>(generated.size()),
+        [&](char* buf, std::size_t max) {
+            std::size_t n = std::min(max, generated.size() - pos);
+            std::memcpy(buf, generated.data() + pos, n);
+            pos += n;
+            return n;
+        },
+        [&] {
+            pos = 0;
+            return true;
+        });
+    conn.setopt(curl::opt::MIMEPOST, form);
+
+    string_sink sink;
+    conn.write_to(sink);
+    for (int i = 0; i < 2; ++i) {
+        INFO("request " << i);
+        sink.reset();
+        conn.perform();
+        CHECK(conn.getinfo(curl::info::RESPONSE_CODE) == 200);
+        CHECK(count(sink.body, "name=\"buffer\"") == 1);
+        CHECK(count(sink.body, payload) == 1);
+        CHECK(count(sink.body, "name=\"callback\"") == 1);
+        CHECK(count(sink.body, generated) == 1);
+    }
+}
+
+TEST_CASE("mime callback part without rewind can only be posted once") {
+    curl::global_init init;
+    echo_server server;
+    curl::easy conn;
+    conn.setopt(curl::opt::URL, server.url().c_str());
+
+    const std::string generated = "one-shot data";
+    std::size_t pos = 0;
+
+    curl::mime form(conn.handle());
+    form.add_part().name("once").callback(static_cast<curl_off_t>(generated.size()),
+        [&](char* buf, std::size_t max) {
+            std::size_t n = std::min(max, generated.size() - pos);
+            std::memcpy(buf, generated.data() + pos, n);
+            pos += n;
+            return n;
+        });
+    conn.setopt(curl::opt::MIMEPOST, form);
+
+    string_sink sink;
+    conn.write_to(sink);
+    conn.perform();
+    CHECK(count(sink.body, generated) == 1);
+
+    CHECK_THROWS_AS(conn.perform(), curl::error);
+}
+
+TEST_CASE("mime is not shared with duphandle copies") {
+    curl::global_init init;
+    echo_server server;
+    curl::easy conn;
+    conn.setopt(curl::opt::URL, server.url().c_str());
+
+    static const char payload[] = "shared buffer payload";
+    const std::string generated = "shared callback data";
+    std::size_t pos = 0;
+
+    curl::mime form(conn.handle());
+    form.add_part().name("buffer").buffer(payload, sizeof(payload) - 1);
+    form.add_part().name("callback").callback(static_cast<curl_off_t>(generated.size()),
+        [&](char* buf, std::size_t max) {
+            std::size_t n = std::min(max, generated.size() - pos);
+            std::memcpy(buf, generated.data() + pos, n);
+            pos += n;
+            return n;
+        },
+        [&] {
+            pos = 0;
+            return true;
+        });
+    conn.setopt(curl::opt::MIMEPOST, form);
+
+    string_sink sink;
+    {
+        curl::easy copy = conn.duphandle();
+        curl::mime copy_form(copy.handle());
+        copy_form.add_part().name("copy").data(std::string("copy data"));
+        copy.setopt(curl::opt::MIMEPOST, copy_form);
+        copy.write_to(sink);
+        copy.perform();
+        CHECK(count(sink.body, "copy data") == 1);
+        CHECK(count(sink.body, payload) == 0);
+    }
+
+    conn.write_to(sink);
+    conn.perform();
+    CHECK(count(sink.body, payload) == 1);
+    CHECK(count(sink.body, generated) == 1);
+}
@@ -0,0 +1,208 @@
+#include <curlpp/stream.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+    struct collect {
+        std::vector<std::string>* lines;
+        void operator()(const char* data, std::size_t size) {
+            lines->emplace_back(data, size);
+        }
+    };
+
+    void feed_in_chunks(curl::line_splitter<collect>& splitter, const std::string& in, std::size_t chunk) {
+        for (std::size_t i = 0; i < in.size(); i += chunk)
+            splitter.feed(in.data() + i, std::min(chunk, in.size() - i));
+    }
+
+    std::vector<curl::json_token_type> token_types(const std::string& doc) {
+        curl::json_tokenizer tok(doc);
+        curl::json_token t;
+        std::vector<curl::json_token_type> types;
+        while (tok.next(t))
+            types.push_back(t.type);
+        return types;
+    }
+
+    void drain(const std::string& doc) {
+        curl::json_tokenizer tok(doc);
+        curl::json_token t;
+        while (tok.next(t)) {}
+    }
+
+    std::string single_string(const std::string& doc) {
+        curl::json_tokenizer tok(doc);
+        curl::json_token t;
+        REQUIRE(tok.next(t));
+        REQUIRE(t.type == curl::json_token_type::STRING);
+        return t.str();
+    }
+}
+
+TEST_CASE("line_splitter splits lines across chunk boundaries") {
+    const std::string in = "first\r\nsecond\n\nthird line\r\nlast\n";
+    const std::vector<std::string> expected = {"first", "second", "", "third line", "last"};
+
+    for (std::size_t chunk = 1; chunk <= in.size(); ++chunk) {
+        std::vector<std::string> lines;
+        curl::line_splitter<collect> splitter(collect{&lines});
+        feed_in_chunks(splitter, in, chunk);
+        splitter.finish();
+        INFO("chunk size " << chunk);
+        CHECK(lines == expected);
+    }
+}
+
+TEST_CASE("line_splitter handles \\r and \\n in separate chunks") {
+    std::vector<std::string> lines;
+    curl::line_splitter<collect> splitter(collect{&lines});
+    splitter.feed("abc\r", 4);
+    CHECK(lines.empty());
+    splitter.feed("\ndef", 4);
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0] == "abc");
+    splitter.finish();
+    CHECK(lines == std::vector<std::string>{"abc", "def"});
+}
+
+TEST_CASE("line_splitter finish") {
+    std::vector<std::string> lines;
+    curl::line_splitter<collect> splitter(collect{&lines});
+
+    SECTION("flushes a line without trailing newline") {
+        splitter.feed("a\nb", 3);
+        splitter.finish();
+        CHECK(lines == std::vector<std::string>{"a", "b"});
+    }
+    SECTION("does nothing after a trailing newline") {
+        splitter.feed("a\nb\n", 4);
+        splitter.finish();
+        CHECK(lines == std::vector<std::string>{"a", "b"});
+    }
+    SECTION("is idempotent") {
+        splitter.feed("a", 1);
+        splitter.finish();
+        splitter.finish();
+        CHECK(lines == std::vector<std::string>{"a"});
+    }
+}
+
+TEST_CASE("line_splitter reset drops a partial line") {
+    std::vector<std::string> lines;
+    curl::line_splitter<collect> splitter(collect{&lines});
+    splitter.feed("{\"a\":1}\n{\"b\":", 13);
+    splitter.reset();
+    splitter.feed("{\"c\":3}\n", 8);
+    CHECK(lines == std::vector<std::string>{"{\"a\":1}", "{\"c\":3}"});
+}
+
+TEST_CASE("line_splitter enforces max_line") {
+    std::vector<std::string> lines;
+    curl::line_splitter<collect> splitter(collect{&lines}, 4);
+
+    SECTION("within a chunk") {
+        CHECK_NOTHROW(splitter.feed("abcd\n", 5));
+        CHECK_THROWS_AS(splitter.feed("abcde\n", 6), std::length_error);
+    }
+    SECTION("across chunks") {
+        splitter.feed("ab", 2);
+        splitter.feed("cd", 2);
+        CHECK_THROWS_AS(splitter.feed("e", 1), std::length_error);
+    }
+    SECTION("in the unterminated tail") {
+        CHECK_THROWS_AS(splitter.feed("abcdef", 6), std::length_error);
+    }
+}
+
+TEST_CASE("json_tokenizer produces tokens") {
+    using T = curl::json_token_type;
+    CHECK(token_types(R"({"a": [1, -2.5e3, true, false, null], "b": {}})") == std::vector<T>{
+        T::BEGIN_OBJECT,
+            T::KEY, T::BEGIN_ARRAY, T::NUMBER, T::NUMBER, T::BOOLEAN, T::BOOLEAN, T::NULL_VALUE, T::END_ARRAY,
+            T::KEY, T::BEGIN_OBJECT, T::END_OBJECT,
+        T::END_OBJECT,
+    });
+    CHECK(token_types(" 42 ") == std::vector<T>{T::NUMBER});
+    CHECK(token_types("[]") == std::vector<T>{T::BEGIN_ARRAY, T::END_ARRAY});
+
+    const std::string doc = "[true,false]";
+    curl::json_tokenizer tok(doc);
+    curl::json_token t;
+    REQUIRE(tok.next(t));
+    REQUIRE(tok.next(t));
+    CHECK(t.boolean());
+    REQUIRE(tok.next(t));
+    CHECK_FALSE(t.boolean());
+}
+
+TEST_CASE("json_tokenizer rejects malformed documents") {
+    const char* docs[] = {
+        "[1,]",
+        "01",
+        "{\"a\"}",
+        "{\"a\":1} x",
+        "[1 2]",
+        "{\"a\":1,}",
+        "[1}",
+        "\"abc",
+        "tru",
+        "-",
+        "1.",
+        "1e",
+        "",
+        "\"\\x\"",
+        "\"\\u12G4\"",
+        "\"\\u12\"",
+        "\"a\tb\"",
+    };
+    for (const char* doc : docs) {
+        INFO(doc);
+        CHECK_THROWS_AS(drain(doc), curl::json_error);
+    }
+}
+
+TEST_CASE("json_token::str decodes escapes") {
+    CHECK(single_string(R"("plain")") == "plain");
+    CHECK(single_string(R"("a\"b\\c\/d\b\f\n\r\t")") == "a\"b\\c/d\b\f\n\r\t");
+    CHECK(single_string(R"("\u0041\u00e9\u20AC")") == "A\xC3\xA9\xE2\x82\xAC");
+    CHECK(single_string(R"("\ud83d\ude00")") == "\xF0\x9F\x98\x80");
+    CHECK_THROWS_AS(single_string(R"("\ud83d")"), curl::json_error);
+    CHECK_THROWS_AS(single_string(R"("\ud83d\u0041")"), curl::json_error);
+    CHECK_THROWS_AS(single_string(R"("\udc00")"), curl::json_error);
+    CHECK_THROWS_AS(single_string(R"("\ude00\ud83d")"), curl::json_error);
+}
+
+TEST_CASE("json_tokenizer reset starts a new document") {
+    const std::string first = "{\"a\":[1";
+    const std::string second = "[true]";
+    curl::json_tokenizer tok(first);
+    curl::json_token t;
+    while (tok.depth() < 2)
+        REQUIRE(tok.next(t));
+
+    tok.reset(second.data(), second.size());
+    CHECK(tok.depth() == 0);
+    std::vector<curl::json_token_type> types;
+    while (tok.next(t))
+        types.push_back(t.type);
+    using T = curl::json_token_type;
+    CHECK(types == std::vector<T>{T::BEGIN_ARRAY, T::BOOLEAN, T::END_ARRAY});
+}
+
+TEST_CASE("ndjson_sink calls back once per record") {
+    std::vector<std::string> keys;
+    auto sink = curl::make_ndjson_sink([&](curl::json_tokenizer& rec) {
+        curl::json_token t;
+        while (rec.next(t))
+            if (t.type == curl::json_token_type::KEY)
+                keys.push_back(t.str());
+    });
+    const std::string in = "{\"a\":1}\r\n\n   \n{\"b\":[2]}\n{\"c\":3}";
+    for (std::size_t i = 0; i < in.size(); i += 5)
+        sink.feed(in.data() + i, std::min<std::size_t>(5, in.size() - i));
+    sink.finish();
+    CHECK(keys == std::vector<std::string>{"a", "b", "c"});
+}
@@ -0,0 +1,27 @@
+#include <curlpp/url.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+TEST_CASE("URL parses, modifies and copies urls") {
+    curl::URL url;
+    url.set(curl::url_part::URL, "https://user@example.com:8443/path?q=1#frag");
+    CHECK(std::string(url.get(curl::url_part::HOST).get()) == "example.com");
+    CHECK(std::string(url.get(curl::url_part::PORT).get()) == "8443");
+    CHECK(std::string(url.get(curl::url_part::QUERY).get()) == "q=1");
+
+    curl::URL copy(url);
+    copy.set(curl::url_part::PATH, std::string("/other"));
+    CHECK(std::string(copy.get(curl::url_part::URL).get()) == "https://user@example.com:8443/other?q=1#frag");
+    CHECK(std::string(url.get(curl::url_part::PATH).get()) == "/path");
+
+    url = copy;
+    CHECK(std::string(url.get(curl::url_part::PATH).get()) == "/other");
+}
+
+TEST_CASE("URL reports errors") {
+    curl::URL url;
+    CHECK_THROWS_AS(url.get(curl::url_part::HOST), curl::url_error);
+    CHECK_THROWS_AS(url.set(curl::url_part::URL, "http://host:99999999/"), curl::url_error);
+}